@@ -3,14 +3,57 @@
 # SPDX-License-Identifier: BSD-3-Clause
 
 from jinja2 import Environment, FileSystemLoader
+import argparse
+import hashlib
+import json
 import os
 import pathlib
+import random
 from enum import Enum
 
 env = Environment(
     loader=FileSystemLoader(".")
 )
 
+defaultdisciplines = ['conflict', 'sync', 'atomic', 'hybrid', 'misc']
+
+parser = argparse.ArgumentParser(prog="RMARaceBench Generator",
+                                 description="Generates the test cases of RMARaceBench from the templates")
+parser.add_argument('--discipline', dest='disciplines', default=defaultdisciplines, help='Select discipline(s) that should be generated (space-separated, default: all disciplines except scenario, random, syncmatrix, and perf)', choices=['conflict', 'sync', 'atomic', 'hybrid', 'misc', 'scenario', 'random', 'syncmatrix', 'perf'], nargs='+', type=str)
+parser.add_argument('--exhaustive', dest='exhaustive', action='store_true', help='Generate the full matrix of operation pairs in discipline conflict instead of one representative operation per access kind')
+parser.add_argument('-o', '--output-folder', dest='output_folder', default='.', help='Output folder for the generated test cases (default: current folder)', type=str)
+parser.add_argument('--manifest', dest='manifest_file', default='manifest.json', help='Output file for the manifest of generated test cases with content hashes (default: manifest.json)', type=str)
+parser.add_argument('--statistics', dest='statistics_file', default='statistics.json', help='Output file for the generation statistics per model, discipline, access set and synchronization call (default: statistics.json)', type=str)
+parser.add_argument('--random-programs', dest='random_programs', default=100, help='Number of random MPI RMA programs generated in discipline random (default: 100)', type=int)
+parser.add_argument('--seed', dest='seed', default=0, help='Seed for the random program generator, every program is reproducible from the seed (default: 0)', type=int)
+parser.add_argument('--random-max-procs', dest='random_max_procs', default=4, help='Maximum number of ranks of a random program (default: 4)', type=int)
+parser.add_argument('--random-max-windows', dest='random_max_windows', default=3, help='Maximum number of windows of a random program (default: 3)', type=int)
+parser.add_argument('--random-segments', dest='random_segments', default=4, help='Number of synchronization segments of a random program (default: 4)', type=int)
+parser.add_argument('--random-max-ops', dest='random_max_ops', default=4, help='Maximum number of statements per rank and segment of a random program (default: 4)', type=int)
+parser.add_argument('--random-size', dest='random_size', default=10, help='Number of elements of windows and local buffers of a random program, larger sizes lead to fewer races (default: 10)', type=int)
+parser.add_argument('--perf-ops', dest='perf_ops', default=[1000, 100000, 10000000], help='Number of RMA operations per epoch (MPI RMA) or between quiets (SHMEM) in discipline perf (space-separated, default: 1000 100000 10000000)', nargs='+', type=int)
+parser.add_argument('--perf-window-bytes', dest='perf_window_bytes', default=[2**20, 2**26, 2**30, 2**35], help='Window sizes in bytes of the large window tests in discipline perf, bounded at run time by RRB_MAX_WIN_BYTES (space-separated, default: 1 MiB 64 MiB 1 GiB 32 GiB)', nargs='+', type=int)
+parser.add_argument('--perf-window-accesses', dest='perf_window_accesses', default=100000, help='Number of RMA accesses of the large window, many window, and symmetric heap tests in discipline perf (default: 100000)', type=int)
+parser.add_argument('--perf-epochs', dest='perf_epochs', default=[1000, 100000, 1000000], help='Number of epochs of the epoch churn tests in discipline perf (space-separated, default: 1000 100000 1000000)', nargs='+', type=int)
+parser.add_argument('--perf-procs', dest='perf_procs', default=[2, 4, 16, 64, 256, 1024], help='Number of processes of the rank scaling tests in discipline perf (space-separated, default: 2 4 16 64 256 1024)', nargs='+', type=int)
+parser.add_argument('--perf-rounds', dest='perf_rounds', default=100, help='Number of access and synchronization rounds of the rank scaling tests in discipline perf (default: 100)', type=int)
+parser.add_argument('--perf-blocks', dest='perf_blocks', default=[1000, 10000, 100000], help='Number of blocks of the derived datatype tests and the SHMEM strided tests in discipline perf (space-separated, default: 1000 10000 100000)', nargs='+', type=int)
+parser.add_argument('--perf-iters', dest='perf_iters', default=[1000, 100000, 1000000], help='Number of producer/consumer iterations of the shared window tests in discipline perf (space-separated, default: 1000 100000 1000000)', nargs='+', type=int)
+parser.add_argument('--perf-regions', dest='perf_regions', default=[1000, 10000], help='Number of attached regions of the dynamic window tests in discipline perf (space-separated, default: 1000 10000)', nargs='+', type=int)
+parser.add_argument('--perf-requests', dest='perf_requests', default=[1000, 10000, 100000], help='Number of outstanding requests of the request-based RMA tests in discipline perf (space-separated, default: 1000 10000 100000)', nargs='+', type=int)
+parser.add_argument('--perf-hotspot-procs', dest='perf_hotspot_procs', default=[3, 8, 32, 128], help='Number of processes of the hot spot atomic tests in discipline perf (space-separated, default: 3 8 32 128)', nargs='+', type=int)
+parser.add_argument('--perf-hotspot-ops', dest='perf_hotspot_ops', default=100000, help='Number of atomic operations per process of the hot spot atomic tests in discipline perf (default: 100000)', type=int)
+parser.add_argument('--perf-heap-bytes', dest='perf_heap_bytes', default=[2**20, 2**26, 2**30, 2**34], help='Symmetric heap sizes in bytes of the SHMEM heap tests in discipline perf, bounded at run time by RRB_MAX_HEAP_BYTES (space-separated, default: 1 MiB 64 MiB 1 GiB 16 GiB)', nargs='+', type=int)
+parser.add_argument('--perf-pes', dest='perf_pes', default=[2, 16], help='Number of PEs of the SHMEM pipeline tests in discipline perf (space-separated, default: 2 16)', nargs='+', type=int)
+parser.add_argument('--perf-flags', dest='perf_flags', default=[1000, 10000], help='Number of flags of the SHMEM wait/test tests in discipline perf (space-separated, default: 1000 10000)', nargs='+', type=int)
+parser.add_argument('--perf-lock-iters', dest='perf_lock_iters', default=[1000, 100000], help='Number of lock acquisitions per PE of the SHMEM lock tests in discipline perf (space-separated, default: 1000 100000)', nargs='+', type=int)
+parser.add_argument('--perf-messages', dest='perf_messages', default=[10000, 1000000, 10000000], help='Number of messages per producer of the SHMEM signal tests in discipline perf (space-separated, default: 10000 1000000 10000000)', nargs='+', type=int)
+parser.add_argument('--perf-team-pes', dest='perf_team_pes', default=[4, 16, 64, 256], help='Number of PEs of the SHMEM team tests in discipline perf (space-separated, default: 4 16 64 256)', nargs='+', type=int)
+parser.add_argument('--perf-threads', dest='perf_threads', default=[2, 8, 32], help='Number of OpenMP threads with a private context of the SHMEM context tests in discipline perf (space-separated, default: 2 8 32)', nargs='+', type=int)
+parser.add_argument('--perf-notifications', dest='perf_notifications', default=[1024, 16384, 65536], help='Number of notification ids of the GASPI notification tests in discipline perf (space-separated, default: 1024 16384 65536)', nargs='+', type=int)
+parser.add_argument('--perf-queues', dest='perf_queues', default=[2, 8, 16], help='Number of queues of the GASPI queue tests in discipline perf (space-separated, default: 2 8 16)', nargs='+', type=int)
+parser.add_argument('--perf-windows', dest='perf_windows', default=[1, 10, 100, 1000, 10000], help='Number of windows of the many window tests in discipline perf (space-separated, default: 1 10 100 1000 10000)', nargs='+', type=int)
+
 class Model(str, Enum):
     MPIRMA = 'MPIRMA'
     SHMEM  = 'SHMEM'
@@ -56,11 +99,20 @@ caseCounters = {
     'sync': CaseCounter(),
     'atomic': CaseCounter(),
     'hybrid': CaseCounter(),
-    'misc': CaseCounter()
+    'misc': CaseCounter(),
+    'scenario': CaseCounter(),
+    'random': CaseCounter(),
+    'syncmatrix': CaseCounter(),
+    'perf': CaseCounter()
 }
 
+generated_cases = []
+output_folder = '.'
+# test case paths in the manifest are relative to the folder of the manifest
+manifest_folder = '.'
+
 class Operation:
-     def __init__(self, model: Model, opname: str, callname: str, local_opkind: str, remote_opkind: str, opcode: str, additional_declarations = ''):
+     def __init__(self, model: Model, opname: str, callname: str, local_opkind: str, remote_opkind: str, opcode: str, additional_declarations = '', blocking = False, completion = ''):
           self.model = model
           self.name = opname
           self.callname = callname
@@ -68,6 +120,10 @@ class Operation:
           self.remote_opkind = remote_opkind
           self.code = opcode
           self.additional_declarations = additional_declarations
+          # blocking operations are locally completed on return
+          self.blocking = blocking
+          # code to complete the operation (e.g., for request-based operations)
+          self.completion = completion
     
      def __str__(self):
           return self.name
@@ -94,8 +150,8 @@ class OperationManager:
           for model in Model:
                self.operations[model] = {}
 
-     def add(self, model: Model, name: str, short_name: str, callname: str, local_opkind: str, remote_opkind: str, code: str, additional_declarations = ''):
-           self.operations[model][name] = Operation(model, short_name, callname, local_opkind, remote_opkind, code, additional_declarations)
+     def add(self, model: Model, name: str, short_name: str, callname: str, local_opkind: str, remote_opkind: str, code: str, additional_declarations = '', blocking = False, completion = ''):
+           self.operations[model][name] = Operation(model, short_name, callname, local_opkind, remote_opkind, code, additional_declarations, blocking, completion)
 
      def get(self, model: Model, name: str) -> Operation:
           return self.operations[model][name]
@@ -111,8 +167,9 @@ om.add(Model.MPIRMA, 'acc2', 'acc', 'MPI_Accumulate', 'local buffer read', 'rma
 om.add(Model.MPIRMA, 'get', 'get', 'MPI_Get', 'local buffer write', 'rma read', 'MPI_Get(&value, 1, MPI_INT, 1, 0, 1, MPI_INT, win);')
 om.add(Model.MPIRMA, 'remote_load', 'load', 'LOAD', 'load', 'load', 'printf("win_base[0] is %d\\n", win_base[0]);')
 om.add(Model.MPIRMA, 'remote_store', 'store', 'STORE', 'store', 'store', 'win_base[0] = 42;')
-om.add(Model.MPIRMA, 'rget', 'rget','MPI_Rget', 'local buffer write', 'rma read', 'MPI_Rget(&value, 1, MPI_INT, 1, 0, 1, MPI_INT, win, &req);')
-om.add(Model.MPIRMA, 'rput', 'rput','MPI_Rput', 'local buffer read', 'rma write', 'MPI_Rput(&value, 1, MPI_INT, 1, 0, 1, MPI_INT, win, &req);')
+om.add(Model.MPIRMA, 'rget', 'rget','MPI_Rget', 'local buffer write', 'rma read', 'MPI_Rget(&value, 1, MPI_INT, 1, 0, 1, MPI_INT, win, &req);', 'MPI_Request req;', completion='MPI_Wait(&req, MPI_STATUS_IGNORE);')
+om.add(Model.MPIRMA, 'rput', 'rput','MPI_Rput', 'local buffer read', 'rma write', 'MPI_Rput(&value, 1, MPI_INT, 1, 0, 1, MPI_INT, win, &req);', 'MPI_Request req;', completion='MPI_Wait(&req, MPI_STATUS_IGNORE);')
+om.add(Model.MPIRMA, 'racc', 'racc','MPI_Raccumulate', 'local buffer read', 'rma atomic write', 'MPI_Raccumulate(&value, 1, MPI_INT, 1, 0, 1, MPI_INT, MPI_SUM, win, &req);', 'MPI_Request req;', completion='MPI_Wait(&req, MPI_STATUS_IGNORE);')
 
 om.add(Model.MPIRMA, 'gacc1', 'gacc', 'MPI_Get_accumulate', 'local buffer read', 'rma atomic write', 'MPI_Get_accumulate(&value, 1, MPI_INT, &value2, 1, MPI_INT, 1, 0, 1, MPI_INT, MPI_SUM, win);')
 om.add(Model.MPIRMA, 'gacc2', 'gacc', 'MPI_Get_accumulate', 'local buffer write', 'rma atomic write', 'MPI_Get_accumulate(&value2, 1, MPI_INT, &value, 1, MPI_INT, 1, 0, 1, MPI_INT, MPI_SUM, win);')
@@ -127,27 +184,29 @@ om.add(Model.SHMEM, 'local_load', 'load', 'LOAD', 'load', 'load', 'printf("local
 om.add(Model.SHMEM, 'local_store', 'store', 'STORE', 'store', 'store','localbuf = 42;')
 om.add(Model.SHMEM, 'putnbi', 'putnbi', 'shmem_int_put_nbi', 'local buffer read', 'rma write', 'shmem_int_put_nbi(&remote, &localbuf, 1, 1);')
 om.add(Model.SHMEM, 'putnbi2', 'putnbi', 'shmem_int_put_nbi', 'local buffer read', 'rma write', 'shmem_int_put_nbi(&remote, &localbuf, 1, 0);')
-om.add(Model.SHMEM, 'put', 'put', 'shmem_int_put', 'local buffer read', 'rma write', 'shmem_int_put(&remote, &localbuf, 1, 1);')
-om.add(Model.SHMEM, 'atomicset', 'atomicset', 'shmem_int_atomic_set', 'local buffer read', 'rma atomic write', 'shmem_int_atomic_set(&remote, 1, 1);')
-om.add(Model.SHMEM, 'atomicfetch', 'atomicfetch', 'shmem_int_atomic_fetch', 'local buffer write', 'rma atomic read', 'localbuf = shmem_int_atomic_fetch(&remote, 1);')
-om.add(Model.SHMEM, 'atomicfetchinc', 'atomicfetchinc', 'shmem_int_atomic_fetch', 'local buffer write', 'rma atomic write', 'localbuf = shmem_int_atomic_fetch_inc(&remote, 1);')
+om.add(Model.SHMEM, 'put', 'put', 'shmem_int_put', 'local buffer read', 'rma write', 'shmem_int_put(&remote, &localbuf, 1, 1);', blocking=True)
+om.add(Model.SHMEM, 'atomicset', 'atomicset', 'shmem_int_atomic_set', 'local buffer read', 'rma atomic write', 'shmem_int_atomic_set(&remote, 1, 1);', blocking=True)
+om.add(Model.SHMEM, 'atomicfetch', 'atomicfetch', 'shmem_int_atomic_fetch', 'local buffer write', 'rma atomic read', 'localbuf = shmem_int_atomic_fetch(&remote, 1);', blocking=True)
+om.add(Model.SHMEM, 'atomicfetchinc', 'atomicfetchinc', 'shmem_int_atomic_fetch', 'local buffer write', 'rma atomic write', 'localbuf = shmem_int_atomic_fetch_inc(&remote, 1);', blocking=True)
 om.add(Model.SHMEM, 'atomicfetchincnbi', 'atomicfetchincnbi', 'shmem_int_atomic_fetch_inc_nbi', 'local buffer write', 'rma atomic write', 'shmem_int_atomic_fetch_inc_nbi(&localbuf, &remote, 1);')
 om.add(Model.SHMEM, 'atomicfetchnbi', 'atomicfetchnbi', 'shmem_int_atomic_fetch', 'local buffer write', 'rma atomic read', 'shmem_int_atomic_fetch_nbi(&localbuf, &remote, 1);')
-om.add(Model.SHMEM, 'atomiccompareswap', 'atomiccompareswap', 'shmem_int_compare_swap', 'local buffer write', 'rma atomic write', 'localbuf = shmem_int_atomic_compare_swap(&remote, 42, 1, 1);')
+om.add(Model.SHMEM, 'atomiccompareswap', 'atomiccompareswap', 'shmem_int_compare_swap', 'local buffer write', 'rma atomic write', 'localbuf = shmem_int_atomic_compare_swap(&remote, 42, 1, 1);', blocking=True)
 om.add(Model.SHMEM, 'atomiccompareswapnbi', 'atomiccompareswapnbi', 'shmem_int_compare_swap_nbi', 'local buffer write', 'rma atomic write', 'shmem_int_atomic_compare_swap_nbi(&localbuf, &remote, 42, 1, 1);')
 om.add(Model.SHMEM, 'getnbi', 'getnbi', 'shmem_int_get_nbi', 'local buffer write', 'rma read', 'shmem_int_get_nbi(&localbuf, &remote, 1, 1);')
-om.add(Model.SHMEM, 'get', 'get', 'shmem_int_get', 'local buffer write', 'rma read', 'shmem_int_get(&localbuf, &remote, 1, 1);')
+om.add(Model.SHMEM, 'get', 'get', 'shmem_int_get', 'local buffer write', 'rma read', 'shmem_int_get(&localbuf, &remote, 1, 1);', blocking=True)
 om.add(Model.SHMEM, 'remote_load', 'load', 'LOAD', 'load', 'load', 'printf("remote is %d", remote);')
 om.add(Model.SHMEM, 'remote_store', 'store', 'STORE', 'store', 'store', 'remote = 42;')
-om.add(Model.SHMEM, 'put_remote', 'put', 'shmem_int_put', 'local buffer read', 'rma write',  'int myval = 42;\nshmem_int_put(&remote, &myval, 1, 1);')
-om.add(Model.SHMEM, 'get_remote', 'get', 'shmem_int_get', 'local buffer write', 'rma read', 'shmem_int_get(&localbuf, &remote, 1, 1);')
-om.add(Model.SHMEM, 'put_signal', 'put_signal', 'shmem_int_put_signal', 'local buffer read', 'rma write', 'shmem_int_put_signal(&remote, &localbuf, 1, &ps_sig_addr, 1, SHMEM_SIGNAL_SET, 1);', 'static uint64_t ps_sig_addr = 0;')
-om.add(Model.SHMEM, 'put_signal2', 'put_signal', 'shmem_int_put_signal', 'local buffer read', 'rma write', 'shmem_int_put_signal(&remote, &localbuf, 1, &ps_sig_addr2, 1, SHMEM_SIGNAL_SET, 1);', 'static uint64_t ps_sig_addr2 = 0;')
+om.add(Model.SHMEM, 'put_remote', 'put', 'shmem_int_put', 'local buffer read', 'rma write',  'int myval = 42;\nshmem_int_put(&remote, &myval, 1, 1);', blocking=True)
+om.add(Model.SHMEM, 'get_remote', 'get', 'shmem_int_get', 'local buffer write', 'rma read', 'shmem_int_get(&localbuf, &remote, 1, 1);', blocking=True)
+om.add(Model.SHMEM, 'put_signal', 'put_signal', 'shmem_int_put_signal', 'local buffer read', 'rma write', 'shmem_int_put_signal(&remote, &localbuf, 1, &ps_sig_addr, 1, SHMEM_SIGNAL_SET, 1);', 'static uint64_t ps_sig_addr = 0;', blocking=True)
+om.add(Model.SHMEM, 'put_signal2', 'put_signal', 'shmem_int_put_signal', 'local buffer read', 'rma write', 'shmem_int_put_signal(&remote, &localbuf, 1, &ps_sig_addr2, 1, SHMEM_SIGNAL_SET, 1);', 'static uint64_t ps_sig_addr2 = 0;', blocking=True)
 om.add(Model.SHMEM, 'put_signal_nbi', 'put_signal_nbi', 'shmem_int_put_signal_nbi', 'local buffer read', 'rma write', 'shmem_int_put_signal_nbi(&remote, &localbuf, 1, &psn_sig_addr, 1, SHMEM_SIGNAL_SET, 1);', 'static uint64_t psn_sig_addr = 0;')
-om.add(Model.SHMEM, 'p', 'p', 'shmem_int_p', '', 'rma write', 'shmem_int_p(&remote, 42, 1);')
-om.add(Model.SHMEM, 'g', 'g', 'shmem_int_g', '', 'rma read', 'localbuf = shmem_int_g(&remote, 1);')
-om.add(Model.SHMEM, 'iput', 'iput', 'shmem_int_iput', 'local buffer read', 'rma write', 'shmem_int_iput(&remote, &localbuf, 1, 1, 1, 1);')
-om.add(Model.SHMEM, 'iget', 'iget', 'shmem_int_iget', 'local buffer write', 'rma read', 'shmem_int_iget(&localbuf, &remote, 1, 1, 1, 1);')
+om.add(Model.SHMEM, 'p', 'p', 'shmem_int_p', '', 'rma write', 'shmem_int_p(&remote, 42, 1);', blocking=True)
+om.add(Model.SHMEM, 'g', 'g', 'shmem_int_g', '', 'rma read', 'localbuf = shmem_int_g(&remote, 1);', blocking=True)
+om.add(Model.SHMEM, 'iput', 'iput', 'shmem_int_iput', 'local buffer read', 'rma write', 'shmem_int_iput(&remote, &localbuf, 1, 1, 1, 1);', blocking=True)
+om.add(Model.SHMEM, 'iget', 'iget', 'shmem_int_iget', 'local buffer write', 'rma read', 'shmem_int_iget(&localbuf, &remote, 1, 1, 1, 1);', blocking=True)
+om.add(Model.SHMEM, 'ibput', 'ibput', 'shmem_int_ibput', 'local buffer read', 'rma write', 'shmem_int_ibput(&remote, &localbuf, 1, 1, 1, 1, 1);', blocking=True)
+om.add(Model.SHMEM, 'ibget', 'ibget', 'shmem_int_ibget', 'local buffer write', 'rma read', 'shmem_int_ibget(&localbuf, &remote, 1, 1, 1, 1, 1);', blocking=True)
 
 om.add(Model.GASPI, 'local_load', 'load', 'LOAD', 'load', 'load', 'printf("localbuf[0] is %d\\n", localbuf[0]);')
 om.add(Model.GASPI, 'local_store', 'store', 'STORE', 'store', 'store', 'localbuf[0] = 42;')
@@ -156,7 +215,7 @@ om.add(Model.GASPI, 'remote_store', 'store', 'STORE', 'store', 'store', 'remote_
 om.add(Model.GASPI, 'write', 'write', 'gaspi_write', 'local buffer read', 'rma write', 'gaspi_write(loc_seg_id, 0, 1, remote_seg_id, 0, sizeof(int), queue_id, GASPI_BLOCK);')
 om.add(Model.GASPI, 'write2', 'write', 'gaspi_write', 'local buffer read', 'rma write', 'gaspi_write(loc_seg_id, 0, 0, remote_seg_id, 0, sizeof(int), queue_id, GASPI_BLOCK);')
 om.add(Model.GASPI, 'read', 'read', 'gaspi_read', 'local buffer write', 'rma read', 'gaspi_read(loc_seg_id, 0, 1, remote_seg_id, 0, sizeof(int), queue_id, GASPI_BLOCK);')
-om.add(Model.GASPI, 'fetchadd', 'fetchadd', 'gaspi_atomic_fetch_add', 'local buffer write', 'rma atomic write', 'gaspi_atomic_fetch_add(remote_seg_id, 0, 1, 1, &localbuf[0], GASPI_BLOCK);')
+om.add(Model.GASPI, 'fetchadd', 'fetchadd', 'gaspi_atomic_fetch_add', 'local buffer write', 'rma atomic write', 'gaspi_atomic_fetch_add(remote_seg_id, 0, 1, 1, &localbuf[0], GASPI_BLOCK);', blocking=True)
 om.add(Model.GASPI, 'write_list', 'write_list', 'gaspi_write_list', 'local buffer read', 'rma write', 'gaspi_write_list(1, &loc_seg_id, (gaspi_offset_t[]) {0}, 1, &remote_seg_id, (gaspi_offset_t[]) {0}, (gaspi_size_t[]) {sizeof(int)}, queue_id, GASPI_BLOCK);')
 om.add(Model.GASPI, 'read_list', 'read_list', 'gaspi_read_list', 'local buffer write', 'rma read', 'gaspi_read_list(1, &loc_seg_id, (gaspi_offset_t[]) {0}, 1, &remote_seg_id, (gaspi_offset_t[]) {0}, (gaspi_size_t[]) {sizeof(int)}, queue_id, GASPI_BLOCK);')
 om.add(Model.GASPI, 'write_list_notify', 'write_list_notify', 'gaspi_write_list_notify', 'local buffer read', 'rma write', 'gaspi_write_list_notify(1, &loc_seg_id, (gaspi_offset_t[]) {0}, 1, &remote_seg_id, (gaspi_offset_t[]) {0}, (gaspi_size_t[]) {sizeof(int)}, remote_seg_id, 0, 1, queue_id, GASPI_BLOCK);')
@@ -230,7 +289,69 @@ op_rma_atomic_read = {
     Model.GASPI:  []
 }
 
-def gen_conflict_races():
+def conflicting(kind1: str, kind2: str) -> bool:
+    writes = ['local buffer write', 'store', 'rma write', 'rma atomic write']
+    atomics = ['rma atomic write', 'rma atomic read']
+    return (kind1 in writes or kind2 in writes) and not (kind1 in atomics and kind2 in atomics)
+
+
+# registrations of an operation on another target location (see conflict_matrix)
+target_alternatives = {
+    Model.MPIRMA: {'put': 'put2', 'acc': 'acc2'},
+    Model.SHMEM:  {'putnbi': 'putnbi2'},
+    Model.GASPI:  {'write': 'write2'}
+}
+
+# operations that additionally write a second local buffer (value2), two of them race on it
+result_buffer_ops = {
+    Model.MPIRMA: ['gacc1', 'fop1', 'cas1'],
+    Model.SHMEM:  [],
+    Model.GASPI:  []
+}
+
+
+def conflict_matrix(model: Model):
+    """Crosses all registered RMA operations of a model with each other and with loads / stores.
+    Duplicate registrations that only differ in the target (e.g., put2) are skipped. Local pairs
+    without a local race whose remote accesses conflict use the registration of one of the
+    operations on another target location (target_alternatives) or are skipped, as they would
+    race remotely."""
+    rma_ops = {}
+    for op in om.operations[model].values():
+        if op.callname not in ['LOAD', 'STORE']:
+            rma_ops.setdefault((op.name, op.local_opkind, op.remote_opkind), op)
+    rma_ops = list(rma_ops.values())
+
+    local_combinations = []
+    local_ops = [op for op in rma_ops if op.local_opkind != '']
+    for (i, op1) in enumerate(local_ops):
+        for op2 in [om.get(model, 'local_load'), om.get(model, 'local_store')]:
+            has_race = not op1.blocking and conflicting(op1.local_opkind, op2.local_opkind)
+            local_combinations.append((op1, op2, has_race, 2))
+        for op2 in local_ops[i:]:
+            has_race = not op1.blocking and conflicting(op1.local_opkind, op2.local_opkind)
+            result_buffer_writers = [om.get(model, name) for name in result_buffer_ops[model]]
+            if not has_race and op1 in result_buffer_writers and op2 in result_buffer_writers:
+                continue
+            if not has_race and conflicting(op1.remote_opkind, op2.remote_opkind):
+                if op2.name in target_alternatives[model]:
+                    local_combinations.append((op1, om.get(model, target_alternatives[model][op2.name]), has_race, 2))
+                elif op1.name in target_alternatives[model]:
+                    local_combinations.append((om.get(model, target_alternatives[model][op1.name]), op2, has_race, 2))
+                continue
+            local_combinations.append((op1, op2, has_race, 2))
+
+    remote_combinations = []
+    for (i, op1) in enumerate(rma_ops):
+        for op2 in [om.get(model, 'remote_load'), om.get(model, 'remote_store')]:
+            remote_combinations.append((op1, op2, conflicting(op1.remote_opkind, op2.remote_opkind), 2))
+        for op2 in rma_ops[i:]:
+            remote_combinations.append((op1, op2, conflicting(op1.remote_opkind, op2.remote_opkind), 3))
+
+    return (local_combinations, remote_combinations)
+
+
+def gen_conflict_races(exhaustive=False):
     local_race_combinations = [
         (op_local_buffer_read, op_local_load, False),
         (op_local_buffer_read, op_local_store, True),
@@ -356,6 +477,14 @@ def gen_conflict_races():
         'GASPI': SourceTemplate("templates/GASPI/conflict/GASPI-conflict-op1-op2-remote-race.c.j2", 2, [], remote_race_combinations),
     }
 
+    if exhaustive:
+        for model in Model:
+            (local_combinations, remote_combinations) = conflict_matrix(model)
+            for (src_templates, combinations) in [(local_src_templates, local_combinations), (remote_src_templates, remote_combinations)]:
+                for (op1, op2, has_race, nprocs) in combinations:
+                    render_template(src_templates[model].filename, caseCounters['conflict'].inc_get(model, has_race), model, op1, op2, has_race, nprocs)
+        return
+
     for (ops1, ops2, has_race) in local_race_combinations:
         for model in Model:
             generated_combos = set()
@@ -394,11 +523,12 @@ def gen_conflict_races():
             render_template(filename, caseCounters['conflict'].inc_get(model, has_race), model, op1, op2, has_race, nprocs)
 
 
-def render_template(template_file: str, number: int, model: Model, op1: Operation, op2: Operation, has_race: bool, nprocs: int, threaded:bool=False):
+def render_template(template_file: str, number: int, model: Model, op1: Operation, op2: Operation, has_race: bool, nprocs: int, threaded:bool=False, variant: str=None, params: dict=None):
     out_path, out_basename = os.path.split(template_file)
-    out_path = out_path.replace('templates/', '')
+    out_path = os.path.normpath(os.path.join(output_folder, out_path.replace('templates/', '')))
     out_file = f"{number:03d}-" + \
-               out_basename.replace('race', 'yes' if has_race else 'no') \
+               out_basename.replace('variant', variant if not variant is None else '') \
+                           .replace('race', 'yes' if has_race else 'no') \
                            .replace("op1", op1.name if not op1 is None else '') \
                            .replace("op2", op2.name if not op2 is None else '') \
                            .replace('.j2', '')
@@ -413,7 +543,7 @@ def render_template(template_file: str, number: int, model: Model, op1: Operatio
              access_kind = 'remote'
         else:
              print("No kind: ", out_file)
-        code = template.render(op1=op1, op2=op2, race=has_race, nprocs=nprocs, access_kind=access_kind, threaded=threaded)
+        code = template.render(op1=op1, op2=op2, race=has_race, nprocs=nprocs, access_kind=access_kind, threaded=threaded, params=params if not params is None else {})
         f.write(code)
         f.close()
         os.system(f"clang-format -i {filename}")
@@ -432,10 +562,16 @@ def render_template(template_file: str, number: int, model: Model, op1: Operatio
                     print("ERROR: Found more race conflicts than expected")
         code = code.replace('{race_loc1}', str(race_loc1)).replace('{race_loc2}', str(race_loc2))
 
+    # named line anchors ("// ANCHOR <name>" in the previous line) for test cases with more than one race pair
+    for line_no, line in enumerate(code.splitlines()):
+        if "// ANCHOR " in line:
+            code = code.replace('{anchor_' + line.split('// ANCHOR ')[1].strip() + '}', str(line_no + 2))
+
     with open(filename, 'w') as f:
         f.write(code)
         f.close()
-    
+
+    generated_cases.append(manifest_entry(filename, template_file, model, code))
     print(f"Generated test case {filename}.")
 
 def gen_misc_races():
@@ -506,8 +642,7 @@ def gen_misc_races():
                         render_template(template.filename, caseCounters['misc'].inc_get(model, has_race), model, op1, op2, has_race, nprocs)
 
 
-def gen_sync_races():
-    caseCounter = CaseCounter()
+def gen_sync_races(disciplines=['sync', 'atomic', 'hybrid']):
     mpi_get_load = [(om.get(Model.MPIRMA, 'get'), om.get(Model.MPIRMA, 'local_load'))]
     mpi_put_load = [(om.get(Model.MPIRMA, 'put'), om.get(Model.MPIRMA, 'remote_load'))]
     mpi_put_get = [(om.get(Model.MPIRMA, 'put'), om.get(Model.MPIRMA, 'get'))]
@@ -705,19 +840,730 @@ def gen_sync_races():
 
     for model in Model:
         for (discipline, src_templates) in [('sync', src_sync_templates), ('atomic', src_atomic_templates), ('hybrid', src_hybrid_templates)]:
-            caseCounter = CaseCounter()
+            if discipline not in disciplines:
+                continue
             for src_template in src_templates[model]:
                 for (op1, op2) in src_template.operation_combinations:
                     for has_race in src_template.has_race:
                         filename = src_template.filename
                         render_template(filename, caseCounters[discipline].inc_get(model, has_race), model, op1, op2, has_race, src_template.nprocs, src_template.threaded)
-    
 
-gen_conflict_races()
-gen_sync_races()
-gen_misc_races()
+
+class SyncMatrixTemplate:
+    """Sync pattern template instantiated with every conflict pair of a model. The template orders
+    op1 and op2 with the synchronization if `params.synced` is set and omits it otherwise."""
+    def __init__(self, filename: str, consistency_calls: str, sync_calls: str, applies=lambda op1, op2: True):
+        self.filename = filename
+        self.consistency_calls = consistency_calls
+        self.sync_calls = sync_calls
+        self.applies = applies
+
+
+def active_target(op1: Operation, op2: Operation) -> bool:
+    # request-based operations are only allowed in passive target epochs
+    return op1.completion == '' and op2.completion == ''
+
+
+def local_completion_orders(op1: Operation, op2: Operation) -> bool:
+    # local completion (e.g., MPI_Win_flush_local) only orders conflicting target accesses if op1 fetches data
+    return op2.callname in ['LOAD', 'STORE'] or op1.local_opkind == 'local buffer write' or not conflicting(op1.remote_opkind, op2.remote_opkind)
+
+
+sync_matrix_templates = {Model.MPIRMA: [
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-fence-variant-op1-op2-local-race.c.j2", "MPI_Win_fence", "MPI_Win_fence", active_target),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lock-variant-op1-op2-local-race.c.j2", "MPI_Win_lock,MPI_Win_unlock", ""),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lock-flushlocal-variant-op1-op2-local-race.c.j2", "MPI_Win_lock,MPI_Win_unlock,MPI_Win_flush_local", "", local_completion_orders),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lock-flush-variant-op1-op2-local-race.c.j2", "MPI_Win_lock,MPI_Win_unlock,MPI_Win_flush", ""),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lockall-flushlocalall-variant-op1-op2-local-race.c.j2", "MPI_Win_lock_all,MPI_Win_unlock_all,MPI_Win_flush_local_all", "", local_completion_orders),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lockall-flushall-variant-op1-op2-local-race.c.j2", "MPI_Win_lock_all,MPI_Win_unlock_all,MPI_Win_flush_all", ""),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-pscw-variant-op1-op2-local-race.c.j2", "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait", "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait", active_target),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-request-variant-op1-op2-local-race.c.j2", "MPI_Win_lock_all,MPI_Win_unlock_all,MPI_Wait", "", lambda op1, op2: op1.completion != '' and local_completion_orders(op1, op2)),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-fence-variant-op1-op2-remote-race.c.j2", "MPI_Win_fence", "MPI_Win_fence", active_target),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lock-barrier-variant-op1-op2-remote-race.c.j2", "MPI_Win_lock,MPI_Win_unlock", "MPI_Barrier"),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lock-sendrecv-variant-op1-op2-remote-race.c.j2", "MPI_Win_lock,MPI_Win_unlock", "MPI_Send,MPI_Recv"),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lockall-flush-barrier-variant-op1-op2-remote-race.c.j2", "MPI_Win_lock_all,MPI_Win_unlock_all,MPI_Win_flush", "MPI_Barrier"),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-lock-exclusive-variant-op1-op2-remote-race.c.j2", "MPI_Win_lock,MPI_Win_unlock", "MPI_Win_lock,MPI_Win_unlock"),
+    SyncMatrixTemplate("templates/MPIRMA/syncmatrix/MPI-syncmatrix-pscw-variant-op1-op2-remote-race.c.j2", "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait", "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait", active_target),
+],
+Model.SHMEM: [
+    SyncMatrixTemplate("templates/SHMEM/syncmatrix/shmem-syncmatrix-quiet-variant-op1-op2-local-race.c.j2", "shmem_quiet", ""),
+    SyncMatrixTemplate("templates/SHMEM/syncmatrix/shmem-syncmatrix-barrierall-variant-op1-op2-local-race.c.j2", "shmem_barrier_all", "shmem_barrier_all"),
+    SyncMatrixTemplate("templates/SHMEM/syncmatrix/shmem-syncmatrix-barrierall-variant-op1-op2-remote-race.c.j2", "shmem_barrier_all", "shmem_barrier_all"),
+    SyncMatrixTemplate("templates/SHMEM/syncmatrix/shmem-syncmatrix-quiet-waituntil-variant-op1-op2-remote-race.c.j2", "shmem_quiet", "shmem_int_atomic_set,shmem_int_wait_until"),
+    SyncMatrixTemplate("templates/SHMEM/syncmatrix/shmem-syncmatrix-lock-variant-op1-op2-remote-race.c.j2", "shmem_quiet", "shmem_set_lock,shmem_clear_lock"),
+],
+Model.GASPI: [
+    SyncMatrixTemplate("templates/GASPI/syncmatrix/GASPI-syncmatrix-wait-variant-op1-op2-local-race.c.j2", "gaspi_wait", "", local_completion_orders),
+    SyncMatrixTemplate("templates/GASPI/syncmatrix/GASPI-syncmatrix-wait-barrier-variant-op1-op2-remote-race.c.j2", "gaspi_wait", "gaspi_barrier"),
+    SyncMatrixTemplate("templates/GASPI/syncmatrix/GASPI-syncmatrix-notify-waitsome-variant-op1-op2-remote-race.c.j2", "gaspi_notify", "gaspi_notify,gaspi_notify_waitsome,gaspi_notify_reset",
+                       lambda op1, op2: op1.remote_opkind == 'rma write'),
+]
+}
 
 
+def gen_sync_matrix():
+    for model in Model:
+        (local_combinations, remote_combinations) = conflict_matrix(model)
+        for template in sync_matrix_templates[model]:
+            access_kind = 'local' if '-local-' in template.filename else 'remote'
+            combinations = local_combinations if access_kind == 'local' else remote_combinations
+            for (op1, op2, conflict, nprocs) in combinations:
+                if not template.applies(op1, op2):
+                    continue
+                for synced in [True, False]:
+                    has_race = conflict and not synced
+                    description = f"{'Conflicting' if conflict else 'Non-conflicting'} operations {op1.name} and {op2.name} " \
+                                  f"{'ordered' if synced else 'not ordered'} by {template.sync_calls or template.consistency_calls}"
+                    description += f" leading to a {access_kind} race." if has_race else " with no race."
+                    params = {'synced': synced,
+                              'consistency_calls': template.consistency_calls,
+                              'sync_calls': template.sync_calls,
+                              'description': description}
+                    render_template(template.filename, caseCounters['syncmatrix'].inc_get(model, has_race), model, op1, op2, has_race, nprocs,
+                                    variant='synced' if synced else 'unsynced', params=params)
+
+
+class ScenarioAccess:
+    """Memory access of a scenario. `op` is an OperationManager key available in all models
+    (e.g. 'local_load') or one of the op_* class tables (e.g. op_rma_write). RMA operations
+    always target rank 1, as in the operation table."""
+    def __init__(self, rank: int, op, conflict: bool = False):
+        self.rank = rank
+        self.op = op
+        self.conflict = conflict
+
+    def resolve(self, model: Model) -> Operation:
+        if isinstance(self.op, dict):
+            return self.op[model][0] if len(self.op[model]) > 0 else None
+        return om.get(model, self.op)
+
+
+class ScenarioSync:
+    """Synchronization event of a scenario. Collective events ('barrier') are executed by all
+    ranks, 'local_completion' and 'remote_completion' by `rank`, 'notify' is a point-to-point
+    synchronization from `rank` to `dst`. Events with `race_free_only` are dropped in the race
+    variant of the scenario."""
+    def __init__(self, kind: str, rank: int = None, dst: int = None, race_free_only: bool = False):
+        self.kind = kind
+        self.rank = rank
+        self.dst = dst
+        self.race_free_only = race_free_only
+
+
+class Scenario:
+    def __init__(self, name: str, nprocs: int, access_kind: str, events: list, description: str, has_race=[True, False]):
+        self.name = name
+        self.nprocs = nprocs
+        self.access_kind = access_kind
+        self.events = events
+        self.description = description
+        self.has_race = has_race
+
+    def conflict_pair(self):
+        return [event for event in self.events if isinstance(event, ScenarioAccess) and event.conflict]
+
+
+class ScenarioBackend:
+    """Translates scenarios into the code of one programming model. A sync kind mapped to None
+    is not expressible in the model, scenarios using it are skipped."""
+    def __init__(self, template: str, rank_var: str, prologue: list, epilogue: list, sync_code: dict, declarations: str = ''):
+        self.template = template
+        self.rank_var = rank_var
+        self.prologue = prologue
+        self.epilogue = epilogue
+        self.sync_code = sync_code
+        self.declarations = declarations
+
+    def supports(self, scenario: Scenario) -> bool:
+        for event in scenario.events:
+            if isinstance(event, ScenarioAccess) and event.resolve(self.model) is None:
+                return False
+            if isinstance(event, ScenarioSync) and self.sync_code[event.kind] is None:
+                return False
+        return True
+
+    def sync_lines(self, event: ScenarioSync, notify_id: int):
+        code = self.sync_code[event.kind]
+        if event.kind == 'notify':
+            return [(event.rank, [l.format(dst=event.dst, src=event.rank, id=notify_id) for l in code[0]]),
+                    (event.dst,  [l.format(dst=event.dst, src=event.rank, id=notify_id) for l in code[1]])]
+        return [(event.rank, code)]
+
+    def body(self, scenario: Scenario, has_race: bool):
+        # list of (rank, lines), rank None for code executed by all ranks
+        blocks = [(None, self.prologue)]
+        notify_id = 0
+        for event in scenario.events:
+            if isinstance(event, ScenarioAccess):
+                lines = []
+                if event.conflict and has_race:
+                    lines.append('// CONFLICT')
+                lines += event.resolve(self.model).code.splitlines()
+                blocks.append((event.rank, lines))
+            elif not (event.race_free_only and has_race):
+                blocks += self.sync_lines(event, notify_id)
+                if event.kind == 'notify':
+                    notify_id += 1
+        blocks.append((None, self.epilogue))
+
+        # merge consecutive blocks of the same rank into one conditional
+        merged = []
+        for (rank, lines) in blocks:
+            if len(merged) > 0 and merged[-1][0] == rank:
+                merged[-1][1].extend(lines)
+            else:
+                merged.append((rank, list(lines)))
+
+        code = []
+        for (rank, lines) in merged:
+            if rank is None:
+                code += lines
+            else:
+                code.append(f'if ({self.rank_var} == {rank}) {{')
+                code += ['    ' + l for l in lines]
+                code.append('}')
+            code.append('')
+        return code
+
+    def sync_calls(self, scenario: Scenario, has_race: bool):
+        calls = []
+        for event in scenario.events:
+            if isinstance(event, ScenarioSync) and not (event.race_free_only and has_race):
+                code = self.sync_code[event.kind]
+                for line in (code[0] + code[1] if event.kind == 'notify' else code):
+                    call = line.split('(')[0].split('=')[-1].strip()
+                    if call not in calls:
+                        calls.append(call)
+        return calls
+
+
+scenario_backends = {
+    Model.MPIRMA: ScenarioBackend("templates/MPIRMA/scenario/MPI-scenario-variant-race.c.j2", 'rank',
+        ['MPI_Win_lock_all(0, win);', 'MPI_Barrier(MPI_COMM_WORLD);'],
+        ['MPI_Win_unlock_all(win);'],
+        {
+            'barrier': ['MPI_Barrier(MPI_COMM_WORLD);'],
+            'local_completion': ['MPI_Win_flush_local_all(win);'],
+            'remote_completion': ['MPI_Win_flush_all(win);'],
+            'notify': (['MPI_Send(&token, 1, MPI_INT, {dst}, {id}, MPI_COMM_WORLD);'],
+                       ['MPI_Recv(&token, 1, MPI_INT, {src}, {id}, MPI_COMM_WORLD, MPI_STATUS_IGNORE);']),
+        }),
+    Model.SHMEM: ScenarioBackend("templates/SHMEM/scenario/shmem-scenario-variant-race.c.j2", 'my_pe',
+        ['shmem_barrier_all();'],
+        [],
+        {
+            'barrier': ['shmem_barrier_all();'],
+            'local_completion': ['shmem_quiet();'],
+            'remote_completion': ['shmem_quiet();'],
+            'notify': (['shmem_int_atomic_set(&sync_flags[{id}], 1, {dst});'],
+                       ['shmem_int_wait_until(&sync_flags[{id}], SHMEM_CMP_EQ, 1);']),
+        },
+        'static int sync_flags[16];'),
+    # GASPI provides remote completion of writes only in combination with notifications
+    Model.GASPI: ScenarioBackend("templates/GASPI/scenario/GASPI-scenario-variant-race.c.j2", 'rank',
+        ['gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK);'],
+        [],
+        {
+            'barrier': ['gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK);'],
+            'local_completion': ['gaspi_wait(queue_id, GASPI_BLOCK);'],
+            'remote_completion': None,
+            'notify': (['gaspi_notify(remote_seg_id, {dst}, PROC_NUM + {id}, 1, queue_id, GASPI_BLOCK);'],
+                       ['gaspi_notify_waitsome(remote_seg_id, PROC_NUM + {id}, 1, &notify_id, GASPI_BLOCK);',
+                        'gaspi_notify_reset(remote_seg_id, PROC_NUM + {id}, &notify_val);']),
+        },
+        'gaspi_notification_id_t notify_id;\ngaspi_notification_t notify_val;'),
+}
+
+for model in Model:
+    scenario_backends[model].model = model
+
+
+scenarios = [
+    Scenario('rmawrite-store-localcompletion-local', 2, 'local', [
+        ScenarioAccess(0, op_local_buffer_read, True),
+        ScenarioSync('local_completion', 0, race_free_only=True),
+        ScenarioAccess(0, 'local_store', True),
+    ], 'Local buffer of an RMA write is modified before the write is locally completed.'),
+    Scenario('rmaread-load-localcompletion-local', 2, 'local', [
+        ScenarioAccess(0, op_local_buffer_write, True),
+        ScenarioSync('local_completion', 0, race_free_only=True),
+        ScenarioAccess(0, 'local_load', True),
+    ], 'Local buffer of an RMA read is read before the read is locally completed.'),
+    Scenario('rmaread-store-barrier-remote', 2, 'remote', [
+        ScenarioAccess(0, op_rma_read, True),
+        ScenarioSync('local_completion', 0),
+        ScenarioSync('barrier', race_free_only=True),
+        ScenarioAccess(1, 'remote_store', True),
+    ], 'Remote location read by an RMA read is overwritten by the target without barrier synchronization.'),
+    Scenario('rmawrite-load-barrier-remote', 2, 'remote', [
+        ScenarioAccess(0, op_rma_write, True),
+        ScenarioSync('remote_completion', 0),
+        ScenarioSync('barrier', race_free_only=True),
+        ScenarioAccess(1, 'remote_load', True),
+    ], 'Remote location written by an RMA write is read by the target without barrier synchronization.'),
+    Scenario('rmawrite-load-notify-remote', 2, 'remote', [
+        ScenarioAccess(0, op_rma_write, True),
+        ScenarioSync('remote_completion', 0, race_free_only=True),
+        ScenarioSync('notify', 0, 1),
+        ScenarioAccess(1, 'remote_load', True),
+    ], 'Remote location written by an RMA write is read by the target after a point-to-point synchronization, the write is not remotely completed before.'),
+    Scenario('rmawrite-rmaread-barrier-remote', 3, 'remote', [
+        ScenarioAccess(0, op_rma_write, True),
+        ScenarioSync('remote_completion', 0),
+        ScenarioSync('barrier', race_free_only=True),
+        ScenarioAccess(2, op_rma_read, True),
+    ], 'RMA write and RMA read from different origins on the same target location without barrier synchronization.'),
+    Scenario('rmaatomicwrite-rmaatomicwrite-remote', 3, 'remote', [
+        ScenarioAccess(0, op_rma_atomic_write, True),
+        ScenarioAccess(2, op_rma_atomic_write, True),
+    ], 'Two concurrent atomic RMA operations on the same target location do not race.', [False]),
+]
+
+
+def gen_scenarios():
+    for model in Model:
+        backend = scenario_backends[model]
+        for scenario in scenarios:
+            if not backend.supports(scenario):
+                continue
+            op1, op2 = [access.resolve(model) for access in scenario.conflict_pair()]
+            for has_race in scenario.has_race:
+                params = {'description': scenario.description,
+                          'body': backend.body(scenario, has_race),
+                          'declarations': backend.declarations,
+                          'sync_calls': backend.sync_calls(scenario, has_race)}
+                render_template(backend.template, caseCounters['scenario'].inc_get(model, has_race), model, op1, op2, has_race, scenario.nprocs,
+                                variant=scenario.name, params=params)
+
+
+
+class RandomAccess:
+    """Memory access of a random program. Accesses are issued at position `start` in the program
+    order of `rank` within a segment and are completed at position `end` (equal for loads/stores)."""
+    def __init__(self, segment: int, rank: int, loc: tuple, mode: str, start: int, callname: str, opkind: str, anchor: int):
+        self.segment = segment
+        self.rank = rank
+        self.loc = loc
+        self.mode = mode  # 'r' (read), 'w' (write), or 'a' (atomic)
+        self.start = start
+        self.end = start
+        self.callname = callname
+        self.opkind = opkind
+        self.anchor = anchor
+
+    def conflicts(self, other) -> bool:
+        if self.segment != other.segment or self.loc != other.loc or (self.mode == 'r' and other.mode == 'r') or (self.mode == 'a' and other.mode == 'a'):
+            return False
+        # segments end with a full synchronization, so accesses of different ranks within a
+        # segment are always concurrent, accesses of the same rank only while an RMA operation is pending
+        return self.rank != other.rank or (self.start < other.end and other.start < self.end)
+
+
+random_rma_ops = {
+    # name: (callname, local mode, remote mode, local opkind, remote opkind, code)
+    'put': ('MPI_Put', 'r', 'w', 'local buffer read', 'rma write',
+            'MPI_Put(&localbuf[{i}], 1, MPI_INT, {t}, {d}, 1, MPI_INT, {win});'),
+    'get': ('MPI_Get', 'w', 'r', 'local buffer write', 'rma read',
+            'MPI_Get(&localbuf[{i}], 1, MPI_INT, {t}, {d}, 1, MPI_INT, {win});'),
+    'acc': ('MPI_Accumulate', 'r', 'a', 'local buffer read', 'rma atomic write',
+            'MPI_Accumulate(&localbuf[{i}], 1, MPI_INT, {t}, {d}, 1, MPI_INT, MPI_SUM, {win});'),
+}
+
+random_sync_modes = ['fence', 'lock', 'lockall', 'pscw']
+
+
+class RandomProgram:
+    def __init__(self, rng, nprocs: int, nwins: int, nsegments: int, max_ops: int, win_size: int = 10, buf_size: int = 10):
+        self.rng = rng
+        self.nprocs = nprocs
+        self.nwins = nwins
+        self.win_size = win_size
+        self.buf_size = buf_size
+        self.accesses = []
+        self.sync_calls = ['MPI_Barrier']
+        self.segments = []
+        for _ in range(nsegments):
+            self.segments.append(self.gen_segment(max_ops))
+        self.races = [(a, b) for (i, a) in enumerate(self.accesses) for b in self.accesses[i + 1:] if a.conflicts(b)]
+
+    def add_sync_call(self, *calls):
+        for call in calls:
+            if call not in self.sync_calls:
+                self.sync_calls.append(call)
+
+    def gen_segment(self, max_ops: int):
+        rng = self.rng
+        mode = rng.choice(random_sync_modes)
+        w = rng.randrange(self.nwins)
+        win = f'wins[{w}]'
+        if mode == 'pscw':
+            targets = sorted(rng.sample(range(self.nprocs), rng.randint(1, self.nprocs - 1)))
+            origins = [r for r in range(self.nprocs) if r not in targets]
+        else:
+            targets = origins = list(range(self.nprocs))
+
+        pre, post = [], ['MPI_Barrier(MPI_COMM_WORLD);']
+        if mode == 'fence':
+            pre, post = [f'MPI_Win_fence(0, {win});'], [f'MPI_Win_fence(0, {win});']
+            self.add_sync_call('MPI_Win_fence')
+
+        # per rank list of (code, anchor)
+        stmts = {}
+        for r in range(self.nprocs):
+            code = []
+            pending = []  # (access, target, local completion only)
+            pos = 0
+
+            def access(loc, mode_, callname, opkind):
+                a = RandomAccess(len(self.segments), r, loc, mode_, pos, callname, opkind, len(self.accesses))
+                self.accesses.append(a)
+                return a
+
+            def complete(target=None, local_only=False):
+                for (a, t, is_local) in pending:
+                    if a.end == a.start and (target is None or t == target) and (is_local or not local_only):
+                        a.end = pos
+
+            rma_targets = [t for t in targets if t != r] if r in origins else []
+            if mode == 'lock':
+                rma_targets = [rng.choice(rma_targets)]
+                code.append((f'MPI_Win_lock(MPI_LOCK_SHARED, {rma_targets[0]}, 0, {win});', None))
+                self.add_sync_call('MPI_Win_lock', 'MPI_Win_unlock')
+            elif mode == 'lockall':
+                code.append((f'MPI_Win_lock_all(0, {win});', None))
+                self.add_sync_call('MPI_Win_lock_all', 'MPI_Win_unlock_all')
+            elif mode == 'pscw':
+                group = targets if r in origins else origins
+                code.append((f'MPI_Group_incl(world_group, {len(group)}, (int[]){{{", ".join(map(str, group))}}}, &group);', None))
+                code.append((f'MPI_Win_start(group, 0, {win});' if r in origins else f'MPI_Win_post(group, 0, {win});', None))
+                self.add_sync_call('MPI_Win_start', 'MPI_Win_complete', 'MPI_Win_post', 'MPI_Win_wait')
+
+            for _ in range(rng.randint(0, max_ops)):
+                pos += 1
+                choice = rng.random()
+                if choice < 0.5 and len(rma_targets) > 0:
+                    name = rng.choice(list(random_rma_ops.keys()))
+                    (callname, local_mode, remote_mode, local_opkind, remote_opkind, template) = random_rma_ops[name]
+                    t, d, i = rng.choice(rma_targets), rng.randrange(self.win_size), rng.randrange(self.buf_size)
+                    a_local = access(('buf', r, i), local_mode, callname, local_opkind)
+                    a_remote = access(('win', t, w, d), remote_mode, callname, remote_opkind)
+                    a_remote.anchor = a_local.anchor
+                    pending += [(a_local, t, True), (a_remote, t, False)]
+                    code.append((template.format(i=i, t=t, d=d, win=win), a_local.anchor))
+                elif choice < 0.7 and r in targets:
+                    d = rng.randrange(self.win_size)
+                    if rng.random() < 0.5:
+                        a = access(('win', r, w, d), 'r', 'LOAD', 'load')
+                        code.append((f'sink += win_bases[{w}][{d}];', a.anchor))
+                    else:
+                        a = access(('win', r, w, d), 'w', 'STORE', 'store')
+                        code.append((f'win_bases[{w}][{d}] = {pos};', a.anchor))
+                elif choice < 0.85 or mode in ['fence', 'pscw']:
+                    i = rng.randrange(self.buf_size)
+                    if rng.random() < 0.5:
+                        a = access(('buf', r, i), 'r', 'LOAD', 'load')
+                        code.append((f'sink += localbuf[{i}];', a.anchor))
+                    else:
+                        a = access(('buf', r, i), 'w', 'STORE', 'store')
+                        code.append((f'localbuf[{i}] = {pos};', a.anchor))
+                elif mode == 'lock':
+                    local_only = rng.random() < 0.5
+                    complete(rma_targets[0], local_only)
+                    call = 'MPI_Win_flush_local' if local_only else 'MPI_Win_flush'
+                    code.append((f'{call}({rma_targets[0]}, {win});', None))
+                    self.add_sync_call(call)
+                else:
+                    local_only = rng.random() < 0.5
+                    complete(None, local_only)
+                    call = 'MPI_Win_flush_local_all' if local_only else 'MPI_Win_flush_all'
+                    code.append((f'{call}({win});', None))
+                    self.add_sync_call(call)
+
+            pos += 1
+            complete()
+            if mode == 'lock':
+                code.append((f'MPI_Win_unlock({rma_targets[0]}, {win});', None))
+            elif mode == 'lockall':
+                code.append((f'MPI_Win_unlock_all({win});', None))
+            elif mode == 'pscw':
+                code.append((f'MPI_Win_complete({win});' if r in origins else f'MPI_Win_wait({win});', None))
+                code.append(('MPI_Group_free(&group);', None))
+            stmts[r] = code
+        return (pre, stmts, post)
+
+    def body(self):
+        race_anchors = set([a.anchor for race in self.races for a in race])
+        code = ['MPI_Barrier(MPI_COMM_WORLD);', '']
+        for (pre, stmts, post) in self.segments:
+            code += pre
+            for r in range(self.nprocs):
+                if len(stmts[r]) == 0:
+                    continue
+                code.append(f'if (rank == {r}) {{')
+                for (line, anchor) in stmts[r]:
+                    if anchor in race_anchors:
+                        code.append(f'    // ANCHOR a{anchor}')
+                    code.append('    ' + line)
+                code.append('}')
+            code += post
+            code.append('')
+        return code
+
+
+def gen_random_programs(count: int, seed: int, max_nprocs: int, max_wins: int, nsegments: int, max_ops: int, size: int):
+    model = Model.MPIRMA
+    for index in range(count):
+        # even programs are generated with race, odd ones without race (if found within the attempts)
+        want_race = index % 2 == 0
+        for attempt in range(1000):
+            rng = random.Random(f'{seed}-{index}-{attempt}')
+            program = RandomProgram(rng, rng.randint(2, max_nprocs), rng.randint(1, max_wins), nsegments, max_ops, size, size)
+            if (len(program.races) > 0) == want_race:
+                break
+        has_race = len(program.races) > 0
+        # race kind and access set of each race pair, the labels RACE_KIND and ACCESS_SET are the ones of the first pair
+        race_kinds = ['local' if race[0].loc[0] == 'buf' else 'remote' for race in program.races]
+        access_kind = race_kinds[0] if has_race else 'remote'
+        params = {'body': program.body(),
+                  'races': [[f'{a.callname}@{{anchor_a{a.anchor}}}' for a in race] for race in program.races],
+                  'race_kinds': race_kinds,
+                  'access_set': [a.opkind for a in program.races[0]] if has_race else [],
+                  'access_sets': [[a.opkind for a in race] for race in program.races],
+                  'pscw': 'MPI_Win_start' in program.sync_calls,
+                  'sync_calls': program.sync_calls,
+                  'num_wins': program.nwins,
+                  'win_size': program.win_size,
+                  'buf_size': program.buf_size,
+                  'seed': f'{seed}-{index}-{attempt}'}
+        render_template("templates/MPIRMA/random/MPI-random-variant-race.c.j2", caseCounters['random'].inc_get(model, has_race), model, None, None, has_race, program.nprocs,
+                        variant=f'seed{seed}-{index}-{access_kind}', params=params)
+
+
+class PerfTemplate:
+    """Performance test template. Each variant is a dict of problem size parameters that are rendered as
+    `#define` into a separate test case (overridable at compile time or via RRB_<name> at run time).
+    The number of processes is either fixed by `nprocs` or given by the entry NPROCS of the variant (which is not
+    rendered as `#define`). Only the parameters in `variant_keys` (default: all) are part of the file name.
+    `params` are additional template parameters (e.g., an access pattern) that prefix the file name variant."""
+    def __init__(self, filename: str, nprocs, operation_combinations: list, variants: list, consistency_calls: str, sync_calls: str, description: str, has_race=[True, False], variant_keys=None, params={}):
+        self.filename = filename
+        self.nprocs = nprocs
+        self.operation_combinations = operation_combinations
+        self.variants = variants
+        self.consistency_calls = consistency_calls
+        self.sync_calls = sync_calls
+        self.description = description
+        self.has_race = has_race
+        self.variant_keys = variant_keys
+        self.params = params
+
+
+def perf_templates(options) -> dict:
+    mpi_ops_store = [(om.get(Model.MPIRMA, op), om.get(Model.MPIRMA, 'remote_store')) for op in ['put', 'get', 'acc']]
+    ops_variants = [{'NUM_OPS': ops} for ops in options.perf_ops]
+    mpi_window = [(om.get(Model.MPIRMA, op), om.get(Model.MPIRMA, 'remote_store')) for op in ['put', 'get']]
+    windows_variants = [{'NUM_WINDOWS': windows, 'NUM_ACCESSES': options.perf_window_accesses, 'RACE_WINDOW': -1} for windows in options.perf_windows]
+    epochs_variants = [{'NUM_EPOCHS': epochs} for epochs in options.perf_epochs]
+    mpi_ops_put = [(om.get(Model.MPIRMA, op), om.get(Model.MPIRMA, 'put')) for op in ['put', 'get', 'acc']]
+    datatype_variants = [{'NUM_BLOCKS': blocks, 'BLOCK_LEN': 2} for blocks in options.perf_blocks]
+    mpi_store_load = [(om.get(Model.MPIRMA, 'remote_store'), om.get(Model.MPIRMA, op)) for op in ['remote_load', 'remote_store']]
+    shared_variants = [{'NUM_ITERS': iters, 'CHUNK': 16} for iters in options.perf_iters]
+    dynamic_variants = [{'NUM_REGIONS': regions, 'NUM_ROUNDS': 10, 'MAX_ATTACHED': 64} for regions in options.perf_regions]
+    mpi_requests = [(om.get(Model.MPIRMA, op1), om.get(Model.MPIRMA, op2)) for (op1, op2) in [('rput', 'local_store'), ('rget', 'local_load'), ('racc', 'local_store')]]
+    requests_variants = [{'NUM_REQS': reqs} for reqs in options.perf_requests]
+    mpi_atomics_put = [(om.get(Model.MPIRMA, op), om.get(Model.MPIRMA, 'put')) for op in ['acc', 'fop1', 'cas1', 'gacc1']]
+    hotspot_variants = [{'NPROCS': nprocs, 'NUM_OPS': options.perf_hotspot_ops, 'HOT_ELEMS': elems} for nprocs in options.perf_hotspot_procs for elems in [1, 8]]
+    shmem_heap = [(om.get(Model.SHMEM, op), om.get(Model.SHMEM, 'remote_store')) for op in ['put', 'get']]
+    heap_variants = [{'HEAP_BYTES': size, 'NUM_ACCESSES': options.perf_window_accesses, 'STRIDE': 16, 'CHUNK': 1024, 'RACE_OFFSET': -1} for size in options.perf_heap_bytes]
+    shmem_pipeline_local = [(om.get(Model.SHMEM, 'putnbi'), om.get(Model.SHMEM, 'local_store')), (om.get(Model.SHMEM, 'getnbi'), om.get(Model.SHMEM, 'local_load'))]
+    shmem_pipeline_remote = [(om.get(Model.SHMEM, 'putnbi'), om.get(Model.SHMEM, 'putnbi'))]
+    pipeline_variants = [{'NPROCS': nprocs, 'NUM_OPS': ops, 'NUM_ROUNDS': 10} for nprocs in options.perf_pes for ops in options.perf_ops]
+    shmem_ctx = [(om.get(Model.SHMEM, op), om.get(Model.SHMEM, 'remote_load')) for op in ['putnbi', 'atomicset']]
+    ctx_variants = [{'NUM_THREADS': threads, 'NUM_OPS': 10000, 'NUM_ROUNDS': 10} for threads in options.perf_threads]
+    shmem_team = [(om.get(Model.SHMEM, op), om.get(Model.SHMEM, 'remote_load')) for op in ['put', 'atomicset']]
+    team_variants = [{'NPROCS': nprocs, 'TEAM_SIZE': 2 if nprocs < 16 else 4, 'NUM_ELEMS': 1024, 'NUM_ROUNDS': options.perf_rounds} for nprocs in options.perf_team_pes]
+    shmem_signal = [(om.get(Model.SHMEM, 'put_signal_nbi'), om.get(Model.SHMEM, 'remote_load'))]
+    signal_variants = {signal: [{'NPROCS': nprocs, 'NUM_MSGS': msgs, 'NUM_SLOTS': 64, 'MSG_ELEMS': 8} for nprocs in pes for msgs in options.perf_messages]
+                       for (signal, pes) in [('set', [2]), ('add', options.perf_pes)]}
+    shmem_wait = [(om.get(Model.SHMEM, op), om.get(Model.SHMEM, 'remote_load')) for op in ['put', 'putnbi']]
+    wait_variants = [{'NPROCS': nprocs, 'NUM_FLAGS': flags, 'NUM_ROUNDS': 10} for nprocs in options.perf_pes for flags in options.perf_flags]
+    shmem_strided = [(om.get(Model.SHMEM, 'iput'), om.get(Model.SHMEM, 'iput')), (om.get(Model.SHMEM, 'iget'), om.get(Model.SHMEM, 'iput'))]
+    shmem_blocked = [(om.get(Model.SHMEM, 'ibput'), om.get(Model.SHMEM, 'ibput')), (om.get(Model.SHMEM, 'ibget'), om.get(Model.SHMEM, 'ibput'))]
+    strided_variants = {block_len: [{'NUM_BLOCKS': blocks, 'STRIDE': stride, 'BLOCK_LEN': block_len, 'NUM_ROUNDS': 10} for blocks in options.perf_blocks for stride in [2, 64]] for block_len in [1, 4]}
+    shmem_lock = [(om.get(Model.SHMEM, 'put'), om.get(Model.SHMEM, op)) for op in ['get', 'put']]
+    lock_variants = [{'NPROCS': nprocs, 'NUM_LOCKS': locks, 'NUM_ITERS': iters} for nprocs in options.perf_pes for locks in [1, 64] for iters in options.perf_lock_iters]
+    gaspi_queues = [(om.get(Model.GASPI, 'write'), om.get(Model.GASPI, 'local_store')), (om.get(Model.GASPI, 'read'), om.get(Model.GASPI, 'local_load'))]
+    queues_variants = [{'NUM_QUEUES': queues, 'NUM_ROUNDS': 100} for queues in options.perf_queues]
+    gaspi_notify = [(om.get(Model.GASPI, op), om.get(Model.GASPI, 'remote_load')) for op in ['write_notify', 'write_list_notify']]
+    notify_variants = [{'NUM_IDS': ids, 'NUM_ROUNDS': 10, 'MSG_ELEMS': 4} for ids in options.perf_notifications]
+    ranks_variants = [{'NPROCS': nprocs, 'NUM_ROUNDS': options.perf_rounds} for nprocs in options.perf_procs]
+    window_variants = [{'WIN_BYTES': size, 'NUM_ACCESSES': options.perf_window_accesses, 'RACE_OFFSET': -1} for size in options.perf_window_bytes]
+    strided_window_variants = [{**variant, 'STRIDE': 1024} for variant in window_variants]
+
+    return {Model.MPIRMA: [
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-ops-lock-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, ops_variants,
+                     "MPI_Win_lock,MPI_Win_unlock", "MPI_Barrier", "{NUM_OPS} {op1} operations in a single lock epoch followed by a {op2} at the target"),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-ops-lockall-flush-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, ops_variants,
+                     "MPI_Win_lock_all,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_OPS} {op1} operations in a single lock_all epoch completed with a flush followed by a {op2} at the target"),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-ops-fence-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, ops_variants,
+                     "MPI_Win_fence", "MPI_Win_fence", "{NUM_OPS} {op1} operations in a single fence epoch followed by a {op2} at the target"),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-window-strided-op1-op2-variant-remote-race.c.j2", 2, mpi_window, strided_window_variants,
+                     "MPI_Win_lock_all,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_ACCESSES} strided {op1} operations on a window of {WIN_BYTES} bytes and a {op2} at the target", variant_keys=['WIN_BYTES']),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-window-random-op1-op2-variant-remote-race.c.j2", 2, mpi_window, window_variants,
+                     "MPI_Win_lock_all,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_ACCESSES} randomly scattered {op1} operations on a window of {WIN_BYTES} bytes and a {op2} at the target", variant_keys=['WIN_BYTES']),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-windows-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, windows_variants,
+                     "MPI_Win_lock_all,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_ACCESSES} {op1} operations spread over {NUM_WINDOWS} windows and a {op2} at the target in one of them", variant_keys=['NUM_WINDOWS']),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-epochs-fence-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, epochs_variants,
+                     "MPI_Win_fence", "MPI_Win_fence", "{NUM_EPOCHS} fence epochs with a {op1} and a {op2} on different elements each followed by a final {op1} and a {op2} at the target"),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-epochs-lock-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, epochs_variants,
+                     "MPI_Win_lock,MPI_Win_unlock", "MPI_Barrier", "{NUM_EPOCHS} lock epochs with a {op1} each followed by a {op1} in a last lock epoch and a {op2} at the target"),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-epochs-lockall-flushall-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, epochs_variants,
+                     "MPI_Win_lock_all,MPI_Win_flush_all,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_EPOCHS} lock_all epochs with two {op1} operations separated by a flush_all each followed by a {op1} in a last lock_all epoch and a {op2} at the target"),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-epochs-pscw-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, epochs_variants,
+                     "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait", "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait", "{NUM_EPOCHS} PSCW epochs with a {op1} each followed by a {op1} in a last PSCW epoch and a {op2} at the target"),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-shared-winsync-barrier-op1-op2-variant-remote-race.c.j2", 2, mpi_store_load, shared_variants,
+                     "MPI_Win_lock_all,MPI_Win_sync,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_ITERS} chunks of {CHUNK} elements produced and consumed with stores and loads in a shared window synchronized with MPI_Win_sync and barrier followed by a {op1} and a {op2}", variant_keys=['NUM_ITERS']),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-shared-flag-op1-op2-variant-remote-race.c.j2", 2, mpi_store_load, shared_variants,
+                     "MPI_Win_lock_all,MPI_Win_sync,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Accumulate,MPI_Fetch_and_op", "{NUM_ITERS} chunks of {CHUNK} elements produced and consumed with stores and loads in a shared window synchronized with MPI_Win_sync and flags followed by a {op1} and a {op2}", variant_keys=['NUM_ITERS']),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-dynamic-op1-op2-variant-remote-race.c.j2", 2, mpi_ops_store, dynamic_variants,
+                     "MPI_Win_lock_all,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_ROUNDS} rounds of attaching {NUM_REGIONS} regions to a dynamic window, {op1} operations to them, and detaching them followed by a {op1} and a {op2} on a region reattached at the same address", variant_keys=['NUM_REGIONS']),
+    ] + [PerfTemplate(f"templates/MPIRMA/perf/MPI-perf-requests-{completion}-op1-op2-variant-local-race.c.j2", 2, mpi_requests, requests_variants,
+                      "MPI_Win_lock_all,MPI_Win_unlock_all", f"MPI_{completion.capitalize()}", f"{{NUM_REQS}} outstanding {{op1}} requests completed with MPI_{completion.capitalize()} and a {{op2}} of the buffer of one request")
+         for completion in ['waitall', 'waitany', 'testsome']
+    ] + [PerfTemplate("templates/MPIRMA/perf/MPI-perf-hotspot-op1-op2-variant-remote-race.c.j2", None,
+                      # MPI_Compare_and_swap is not covered by accumulate_ops=same_op
+                      [(op1, op2) for (op1, op2) in mpi_atomics_put if hints != 'sameop' or op1.name != 'cas'], hotspot_variants,
+                      "MPI_Win_lock_all,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Barrier", f"{{NUM_OPS}} {{op1}} operations of each of {{nprocs}} processes except the target on {{HOT_ELEMS}} elements ({description}) and a concurrent {{op2}}",
+                      variant_keys=['NPROCS', 'HOT_ELEMS'], params={'hints': hints})
+         for (hints, description) in [('default', 'default info'), ('ordernone', 'accumulate_ordering=none'), ('sameop', 'accumulate_ops=same_op')]
+    ] + [PerfTemplate(f"templates/MPIRMA/perf/MPI-perf-datatype-{datatype}-op1-op2-variant-remote-race.c.j2", 3, mpi_ops_put, datatype_variants,
+                      "MPI_Win_fence", "MPI_Win_fence", f"{{op1}} and {{op2}} from two origins with an {name} of {{NUM_BLOCKS}} blocks at the target that are interleaved or overlap in one block", variant_keys=['NUM_BLOCKS'])
+         for (datatype, name) in [('vector', 'MPI_Type_vector'), ('indexed', 'MPI_Type_indexed'), ('subarray', 'MPI_Type_create_subarray'), ('struct', 'MPI_Type_create_struct of structs')]
+    ] + [template for pattern in ['ring', 'alltoone', 'alltoall'] for template in [
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-ranks-barrier-op1-op2-variant-remote-race.c.j2", None, mpi_ops_store, ranks_variants,
+                     "MPI_Win_lock,MPI_Win_unlock", "MPI_Barrier", "{NUM_ROUNDS} rounds of {op1} operations of {nprocs} processes in the {pattern} pattern synchronized with lock/unlock and barrier followed by a {op1} and a {op2} at the target", variant_keys=['NPROCS'], params={'pattern': pattern}),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-ranks-sendrecv-op1-op2-variant-remote-race.c.j2", None, mpi_ops_store, ranks_variants,
+                     "MPI_Win_lock,MPI_Win_unlock", "MPI_Isend,MPI_Send,MPI_Recv,MPI_Barrier", "{NUM_ROUNDS} rounds of {op1} operations of {nprocs} processes in the {pattern} pattern synchronized with lock/unlock and send/recv followed by a {op1} and a {op2} at the target", variant_keys=['NPROCS'], params={'pattern': pattern}),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-ranks-lockall-op1-op2-variant-remote-race.c.j2", None, mpi_ops_store, ranks_variants,
+                     "MPI_Win_lock_all,MPI_Win_flush_all,MPI_Win_flush,MPI_Win_unlock_all", "MPI_Barrier", "{NUM_ROUNDS} rounds of {op1} operations of {nprocs} processes in the {pattern} pattern synchronized with flush_all and barrier in a lock_all epoch followed by a {op1} and a {op2} at the target", variant_keys=['NPROCS'], params={'pattern': pattern}),
+        PerfTemplate("templates/MPIRMA/perf/MPI-perf-ranks-pscw-op1-op2-variant-remote-race.c.j2", None, mpi_ops_store, ranks_variants,
+                     "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait", "MPI_Win_start,MPI_Win_complete,MPI_Win_post,MPI_Win_wait,MPI_Barrier", "{NUM_ROUNDS} rounds of {op1} operations of {nprocs} processes in the {pattern} pattern synchronized with PSCW followed by a {op1} and a {op2} at the target", variant_keys=['NPROCS'], params={'pattern': pattern}),
+    ]],
+    Model.SHMEM: [
+        PerfTemplate("templates/SHMEM/perf/shmem-perf-heap-op1-op2-variant-remote-race.c.j2", 2, shmem_heap, heap_variants,
+                     "shmem_quiet", "shmem_barrier_all", f"{{NUM_ACCESSES}} {access} {{op1}} operations on a symmetric heap of {{HEAP_BYTES}} bytes allocated with shmem_{alloc} and a {{op2}} at the target",
+                     variant_keys=['HEAP_BYTES'], params={'alloc': alloc, 'access': access})
+        for alloc in ['malloc', 'calloc', 'align'] for access in ['bulk', 'elementwise']
+    ] + [
+        PerfTemplate("templates/SHMEM/perf/shmem-perf-pipeline-quiet-op1-op2-variant-local-race.c.j2", None, shmem_pipeline_local, pipeline_variants,
+                     "shmem_quiet", "shmem_barrier_all", "{NUM_ROUNDS} rounds of {NUM_OPS} {op1} operations to {nprocs} PEs completed by shmem_quiet that reuse the local buffers followed by a {op1} and a {op2} of its local buffer",
+                     variant_keys=['NPROCS', 'NUM_OPS']),
+        PerfTemplate("templates/SHMEM/perf/shmem-perf-pipeline-fence-op1-op2-variant-remote-race.c.j2", None, shmem_pipeline_remote, pipeline_variants,
+                     "shmem_fence,shmem_quiet", "shmem_barrier_all", "{NUM_ROUNDS} rounds of {NUM_OPS} {op1} operations to {nprocs} PEs ordered by shmem_fence followed by two {op1} operations to the same element",
+                     variant_keys=['NPROCS', 'NUM_OPS']),
+        PerfTemplate("templates/SHMEM/perf/shmem-perf-ctx-op1-op2-variant-remote-race.c.j2", 2, shmem_ctx, ctx_variants,
+                     "shmem_ctx_quiet", "shmem_barrier_all", "{NUM_ROUNDS} rounds of {NUM_OPS} {op1} operations of each of {NUM_THREADS} OpenMP threads on a private context completed by shmem_ctx_quiet followed by a {op1} of each thread and a {op2} at the target",
+                     variant_keys=['NUM_THREADS']),
+    ] + [PerfTemplate("templates/SHMEM/perf/shmem-perf-team-op1-op2-variant-remote-race.c.j2", None, shmem_team, team_variants,
+                      "shmem_quiet", "shmem_team_sync", f"{{NUM_ROUNDS}} rounds of {call} on {description} of {{TEAM_SIZE}} PEs out of {{nprocs}} PEs followed by a {{op1}} and a {{op2}} synchronized with shmem_team_sync of the team of the origin",
+                      variant_keys=['NPROCS'], params={'split': split, 'collective': collective})
+         for (split, description) in [('strided', 'strided teams created with shmem_team_split_strided'), ('2d', 'the row and column teams of shmem_team_split_2d with rows')]
+         for (collective, call) in [('sync', 'shmem_team_sync'), ('broadcast', 'shmem_broadcastmem'), ('alltoall', 'shmem_alltoallmem'), ('reduce', 'shmem_int_sum_reduce')]
+    ] + [PerfTemplate("templates/SHMEM/perf/shmem-perf-signal-op1-op2-variant-remote-race.c.j2", None, shmem_signal, signal_variants[signal],
+                      "shmem_quiet", "shmem_signal_wait_until,shmem_uint64_atomic_set", f"{{NUM_MSGS}} messages of each producer PE ({{nprocs}} PEs in total) sent with {{op1}} and SHMEM_SIGNAL_{signal.upper()} through a ring buffer of {{NUM_SLOTS}} slots to a consumer that acknowledges each message followed by an overwrite of the last slot with a {{op1}} and a {{op2}} of it by the consumer",
+                      variant_keys=['NPROCS', 'NUM_MSGS'], params={'signal': signal})
+         for signal in ['set', 'add']
+    ] + [PerfTemplate("templates/SHMEM/perf/shmem-perf-wait-op1-op2-variant-remote-race.c.j2", None, shmem_wait, wait_variants,
+                      "shmem_fence", f"shmem_int_atomic_set,shmem_int_{kind}_{cond}{vector}", f"{{NUM_ROUNDS}} rounds of {{NUM_FLAGS}} flags set by the producer PEs ({{nprocs}} PEs in total) after a {{op1}} of their data awaited with shmem_int_{kind}_{cond}{vector} followed by a {{op1}} and a {{op2}} of an element after waiting only for the first half of the flags",
+                      variant_keys=['NPROCS', 'NUM_FLAGS'], params={'wait': f"{kind.replace('_until', '')}{cond}{vector.replace('_', '')}"})
+         for kind in ['wait_until', 'test'] for cond in ['all', 'any', 'some'] for vector in ['', '_vector']
+    ] + [PerfTemplate("templates/SHMEM/perf/shmem-perf-strided-op1-op2-variant-remote-race.c.j2", 3, operations, strided_variants[block_len],
+                      "shmem_quiet", "shmem_barrier_all", f"{{NUM_ROUNDS}} rounds of {{op1}} and {{op2}} from two PEs on {{NUM_BLOCKS}} blocks of {{BLOCK_LEN}} elements with a stride of {{STRIDE}} blocks at the target that are interleaved or overlap in one element",
+                      variant_keys=['NUM_BLOCKS', 'STRIDE'])
+         for (operations, block_len) in [(shmem_strided, 1), (shmem_blocked, 4)]
+    ] + [PerfTemplate("templates/SHMEM/perf/shmem-perf-lock-op1-op2-variant-remote-race.c.j2", None, shmem_lock, lock_variants,
+                      "shmem_quiet", f"shmem_{lock}_lock,shmem_clear_lock", f"{{NUM_ITERS}} updates of each of {{nprocs}} PEs on elements guarded by {{NUM_LOCKS}} lock(s) acquired with shmem_{lock}_lock followed by a {{op1}} and a {{op2}} of the same element with and without the lock",
+                      variant_keys=['NPROCS', 'NUM_LOCKS', 'NUM_ITERS'], params={'lock': lock})
+         for lock in ['set', 'test']
+    ],
+    Model.GASPI: [
+        PerfTemplate("templates/GASPI/perf/GASPI-perf-queues-op1-op2-variant-local-race.c.j2", 2, gaspi_queues, queues_variants,
+                     "gaspi_wait", "gaspi_barrier", "{NUM_ROUNDS} rounds of {op1} operations that fill {NUM_QUEUES} queues (all but queue 0 created with gaspi_queue_create) to gaspi_queue_size_max followed by a {op1} on each queue and a {op2} of the local buffer of a queue after waiting only on the even queues",
+                     variant_keys=['NUM_QUEUES']),
+        PerfTemplate("templates/GASPI/perf/GASPI-perf-notify-op1-op2-variant-remote-race.c.j2", 2, gaspi_notify, notify_variants,
+                     "gaspi_wait", "gaspi_notify_waitsome,gaspi_notify_reset", "{NUM_ROUNDS} rounds of {NUM_IDS} messages sent with {op1} on as many notification ids that are awaited with gaspi_notify_waitsome over the range of ids not received yet and reset followed by a {op1} and a {op2} of its message after waiting for its notification or only for another one",
+                     variant_keys=['NUM_IDS']),
+    ]
+    }
+
+
+def gen_perf_tests(options):
+    templates = perf_templates(options)
+    for model in Model:
+        for template in templates[model]:
+            for variant_params in template.variants:
+                variant = '-'.join(list(template.params.values()) + [f"{name.lower().replace('_', '')}{value}" for (name, value) in variant_params.items() if template.variant_keys is None or name in template.variant_keys])
+                nprocs = variant_params.get('NPROCS', template.nprocs)
+                defines = {name: value for (name, value) in variant_params.items() if name != 'NPROCS'}
+                for (op1, op2) in template.operation_combinations:
+                    for has_race in template.has_race:
+                        description = template.description.format(op1=op1.name if op1 else '', op2=op2.name if op2 else '', nprocs=nprocs, **template.params, **defines)
+                        description += ", the last accesses race." if has_race else ", the last accesses are synchronized."
+                        params = {**template.params,
+                                  'defines': defines,
+                                  'consistency_calls': template.consistency_calls,
+                                  'sync_calls': template.sync_calls,
+                                  'description': description[0].upper() + description[1:]}
+                        render_template(template.filename, caseCounters['perf'].inc_get(model, has_race), model, op1, op2, has_race, nprocs,
+                                        variant=variant, params=params)
+
+
+def manifest_entry(filename: str, template_file: str, model: Model, code: str) -> dict:
+    labels = json.loads(code.split('// RACE LABELS BEGIN\n/*')[1].split('*/\n// RACE LABELS END')[0].strip(), strict=False)
+    return {
+        # relative to the folder of the manifest, run_test.py resolves it the same way
+        'file': os.path.relpath(filename, manifest_folder),
+        'sha256': hashlib.sha256(code.encode()).hexdigest(),
+        'template': template_file,
+        'template_sha256': hashlib.sha256(open(template_file, 'rb').read()).hexdigest(),
+        'model': str(model),
+        'discipline': os.path.basename(os.path.dirname(filename)),
+        'race': labels['RACE_KIND'] != 'none',
+        'race_kind': labels['RACE_KIND'],
+        'access_set': labels.get('ACCESS_SET', []),
+        'sync_calls': [call.strip() for calls in labels.get('CONSISTENCY_CALLS', []) + labels.get('SYNC_CALLS', []) for call in calls.split(',') if call.strip() != ''],
+        'nprocs': labels['NPROCS'],
+    }
+
+
+def write_manifest(manifest_file: str, statistics_file: str):
+    # keep the entries of folders that were not generated in this run
+    regenerated = set([os.path.dirname(case['file']) for case in generated_cases])
+    cases = []
+    if os.path.exists(manifest_file):
+        cases = [case for case in json.load(open(manifest_file))['cases'] if os.path.dirname(case['file']) not in regenerated]
+    cases = sorted(cases + generated_cases, key=lambda case: case['file'])
+    with open(manifest_file, 'w') as f:
+        json.dump({'cases': cases}, f, indent=2)
+
+    def count(statistics, key, race):
+        entry = statistics.setdefault(key, {'total': 0, 'race': 0, 'norace': 0})
+        entry['total'] += 1
+        entry['race' if race else 'norace'] += 1
+
+    statistics = {'models': {}, 'disciplines': {}, 'access_sets': {}, 'sync_calls': {}}
+    for case in cases:
+        model = case['model']
+        count(statistics['models'], model, case['race'])
+        count(statistics['disciplines'].setdefault(model, {}), case['discipline'], case['race'])
+        count(statistics['access_sets'].setdefault(model, {}), ' / '.join(case['access_set']), case['race'])
+        for call in set(case['sync_calls']):
+            count(statistics['sync_calls'].setdefault(model, {}), call, case['race'])
+    with open(statistics_file, 'w') as f:
+        json.dump(statistics, f, indent=2)
+
+    print(f"Written manifest {manifest_file} and statistics {statistics_file}.")
+
 def printCases(name: str, counter: CaseCounter):
     print(f"{name}\t", end='')
     for model in Model:
@@ -732,12 +1578,41 @@ def printStaticstics():
     printCases(f'{"Atomic": <16}', caseCounters['atomic'])
     printCases(f'{"Hybrid": <16}', caseCounters['hybrid'])
     printCases(f'{"Misc": <16}', caseCounters['misc'])
+    if sum([caseCounters['scenario'].get(model) for model in Model]) > 0:
+        printCases(f'{"Scenario": <16}', caseCounters['scenario'])
+    if sum([caseCounters['random'].get(model) for model in Model]) > 0:
+        printCases(f'{"Random": <16}', caseCounters['random'])
+    if sum([caseCounters['syncmatrix'].get(model) for model in Model]) > 0:
+        printCases(f'{"Sync matrix": <16}', caseCounters['syncmatrix'])
+    if sum([caseCounters['perf'].get(model) for model in Model]) > 0:
+        printCases(f'{"Performance": <16}', caseCounters['perf'])
     total = CaseCounter()
     for model in Model:
-        for discipline in ['conflict', 'sync', 'atomic', 'hybrid', 'misc']:
+        for discipline in ['conflict', 'sync', 'atomic', 'hybrid', 'misc', 'scenario', 'random', 'syncmatrix', 'perf']:
             total.set(model, total.get(model) + caseCounters[discipline].get(model))
             total.set_races(model, total.get_races(model) + caseCounters[discipline].get_races(model))
     print('\\midrule')
     printCases(f'{"Total": <16}', total)
 
-printStaticstics()
\ No newline at end of file
+
+if __name__ == '__main__':
+    args = parser.parse_args()
+    output_folder = args.output_folder
+    manifest_folder = os.path.dirname(args.manifest_file) or '.'
+
+    if 'conflict' in args.disciplines:
+        gen_conflict_races(args.exhaustive)
+    gen_sync_races(args.disciplines)
+    if 'misc' in args.disciplines:
+        gen_misc_races()
+    if 'syncmatrix' in args.disciplines:
+        gen_sync_matrix()
+    if 'scenario' in args.disciplines:
+        gen_scenarios()
+    if 'random' in args.disciplines:
+        gen_random_programs(args.random_programs, args.seed, args.random_max_procs, args.random_max_windows, args.random_segments, args.random_max_ops, args.random_size)
+    if 'perf' in args.disciplines:
+        gen_perf_tests(args)
+
+    printStaticstics()
+    write_manifest(args.manifest_file, args.statistics_file)
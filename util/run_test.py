@@ -5,6 +5,7 @@
 from enum import Enum
 import subprocess
 from abc import ABC, abstractmethod
+import hashlib
 import json
 import multiprocessing as mp
 import os
@@ -14,6 +15,7 @@ from datetime import datetime
 from glob import glob
 import argparse
 import shutil
+import time
 
 defaultdisciplines = ['conflict', 'sync', 'atomic', 'hybrid']
 defaulttools = ['MUST', 'PARCOACH-dynamic', 'PARCOACH-static']
@@ -24,10 +26,16 @@ parser = argparse.ArgumentParser(prog="RMARaceBench Runner",
                                  description="Runs the tests of RMARaceBench and classifies the results")
 parser.add_argument('mode', choices=['plain', 'tools'], help='Run plain tests (MPI RMA, OpenSHMEM, GASPI) (choice: plain) or the tools on the MPI RMA test cases (choice: tools)', type=str)
 parser.add_argument('--tool', dest='tools', default=defaulttools, help='Select tools that should be tested (space-separated, default: all tools)', choices=['MUST', 'PARCOACH-dynamic', 'PARCOACH-static'], nargs='+', type=str)
-parser.add_argument('--discipline', dest='disciplines', default=defaultdisciplines, help='Select tool(s) that should be tested (space-separated, default: all disciplines)', choices=['conflict', 'sync', 'atomic', 'hybrid', 'misc'], nargs='+', type=str)
+parser.add_argument('--discipline', dest='disciplines', default=defaultdisciplines, help='Select tool(s) that should be tested (space-separated, default: all disciplines)', choices=['conflict', 'sync', 'atomic', 'hybrid', 'misc', 'scenario', 'random', 'syncmatrix', 'perf'], nargs='+', type=str)
 parser.add_argument('--rma-model', dest='rma_models', default=defaultrmamodels, help='Select RMA model(s) that should be tested (space-separated, default: all models)', choices=['MPIRMA', 'SHMEM', 'GASPI'], nargs='+', type=str)
+parser.add_argument('--manifest', dest='manifest', default=None, help='Select test cases from the manifest written by generate.py instead of the test folders, stale test cases whose content hash does not match are skipped')
+parser.add_argument('--timeout', dest='timeout', default=30, help='Timeout in seconds for compiling and running a test case (default: 30), increase it for discipline perf', type=int)
+parser.add_argument('--oversubscribe', dest='oversubscribe', action='store_true', help='Allow more processes than cores in mpirun (mustrun passes it on to mpirun), e.g., for the rank scaling tests of discipline perf')
 parser.add_argument('-o', '--output-folder', dest='output_folder', default='results-' + datetime.now().strftime("%Y%m%d-%H%M%S"), help='Set output folder, default is results-Ymd-HMS')
 
+run_timeout = 30
+mpirun_flags = ''
+
 class Result(str, Enum):
     TP = 'TP',
     FP = 'FP',
@@ -97,16 +105,18 @@ class RunTest(ABC):
     def write_stdout(self, stdout: str):
         self.stdout.write(self.output)
 
-    def run_command(self, command: str, timeout = 30):
+    def run_command(self, command: str, timeout = None):
         result = RunResult.SUCCESS
         self.cmd_out.write(command + '\n')
+        start = time.time()
         p = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
         try:
-            p.wait(timeout=timeout)
+            p.wait(timeout=timeout if timeout is not None else run_timeout)
         except:
             result = RunResult.TIMEOUT
             p.kill()
             return ('', result)
+        self.runtime = time.time() - start
 
         out, _ = p.communicate()
         if p.returncode != 0:
@@ -119,6 +129,15 @@ class RunTest(ABC):
         except UnicodeDecodeError as e:
             return ('decoding error', result)
     
+    def metrics(self):
+        # performance metrics printed by the test case ("RRB_PERF <metric> <value> <unit>") and the run time of the last command
+        metrics = {'runtime': getattr(self, 'runtime', None)}
+        for line in getattr(self, 'output', '').splitlines():
+            if line.startswith('RRB_PERF '):
+                fields = line.split()
+                metrics[fields[1]] = float(fields[2])
+        return metrics
+
     def parse(self, race_string, race1_test='', race2_test=''):
         if self.runresult == RunResult.TIMEOUT:
             return Result.TO
@@ -170,7 +189,7 @@ class RunMPITest(RunTest):
             print("Compilation failed")
             return
 
-        command = f"mpirun -np {self.test.nprocs} {binary_out}"
+        command = f"mpirun {mpirun_flags}-np {self.test.nprocs} {binary_out}"
         self.output, self.runresult = self.run_command(command)
         self.write_stdout(self.output)
 
@@ -193,7 +212,7 @@ class RunSHMEMTest(RunTest):
             print("Compilation failed")
             return
 
-        command = f"mpirun -np {self.test.nprocs} {binary_out}"
+        command = f"mpirun {mpirun_flags}-np {self.test.nprocs} {binary_out}"
         self.output, self.runresult = self.run_command(command)
         self.write_stdout(self.output)
 
@@ -216,7 +235,7 @@ class RunGASPITest(RunTest):
             return
 
 
-        command = f"mpirun -np {self.test.nprocs} {binary_out}"
+        command = f"mpirun {mpirun_flags}-np {self.test.nprocs} {binary_out}"
         self.output, self.runresult = self.run_command(command)
         self.write_stdout(self.output)
 
@@ -233,7 +252,7 @@ class RunMUSTTest(RunTest):
         command = f"mpicc -fopenmp -g -Wl,--whole-archive /opt/must/lib/libonReportLoader.a -Wl,--no-whole-archive -ldl -fsanitize=thread {self.source_file} -o {binary_out}"
         self.run_command(command)
 
-        command = f"mustrun -np {self.test.nprocs} --must:distributed --must:nodl --must:output stdout --must:tsan --must:rma {binary_out}"
+        command = f"mustrun {mpirun_flags}-np {self.test.nprocs} --must:distributed --must:nodl --must:output stdout --must:tsan --must:rma {binary_out}"
         self.output, self.runresult = self.run_command(command)
         self.write_stdout(self.output)
 
@@ -273,7 +292,7 @@ class RunParcoachDynamicTest(RunTest):
         self.run_command(f"parcoach -S --check=rma {binary_out}.ll -o {binary_out}-instrumented.ll")
         self.run_command(f"mpicc -fopenmp -O0 -g {binary_out}-instrumented.ll -o {binary_out}-instrumented.exe -Wl,-rpath=/opt/parcoach/lib /opt/parcoach/lib/libParcoachInstrumentation.so")
 
-        command = f"mpirun -np {self.test.nprocs} {binary_out}-instrumented.exe"
+        command = f"mpirun {mpirun_flags}-np {self.test.nprocs} {binary_out}-instrumented.exe"
         self.output = "timeout"
         for i in range(10): # need multiple retries since PARCOACH-dynamic sometimes just hangs
             ret, self.runresult = self.run_command(command, timeout=3)
@@ -298,7 +317,7 @@ def run_tool_test(filename: str, prefix: str, tool: str, category: str):
     mt = RunTestFactory.createTest(t, prefix, tool, category)
     mt.run()
     print(os.path.basename(filename) + ': ' + mt.parse())
-    return os.path.basename(filename), mt.parse()
+    return os.path.basename(filename), mt.parse(), mt.metrics() if category == 'perf' else {}
 
 def run_plain_test(filename: str, prefix: str, model: str, category: str):
     print(os.path.basename(filename))
@@ -306,19 +325,43 @@ def run_plain_test(filename: str, prefix: str, model: str, category: str):
     mt = RunTestFactory.createTest(t, prefix, model, category)
     mt.run()
     print(os.path.basename(filename) + ': ' + mt.parse())
-    return os.path.basename(filename), mt.parse()
+    return os.path.basename(filename), mt.parse(), mt.metrics() if category == 'perf' else {}
+
+
+def get_testfiles(model: str, discipline: str, manifest_file: str):
+    if manifest_file is None:
+        testfiles = glob(f"/rmaracebench/{model}/{discipline}/*.c")
+    else:
+        testfiles = []
+        # test case paths in the manifest are relative to the folder of the manifest (see generate.py)
+        base = os.path.dirname(os.path.abspath(manifest_file))
+        for case in json.load(open(manifest_file))['cases']:
+            if case['model'] != model or case['discipline'] != discipline:
+                continue
+            filename = os.path.join(base, case['file'])
+            if not os.path.exists(filename) or hashlib.sha256(open(filename, 'rb').read()).hexdigest() != case['sha256']:
+                print(f"Skipping stale test case {case['file']}, regenerate it with generate.py")
+                continue
+            testfiles.append(filename)
+    testfiles.sort()
+    return testfiles
 
 
 def results_append(results_dict, results, name, discipline):
-    for testname, result in results:
+    for testname, result, metrics in results:
         if testname not in results_dict.keys():
             results_dict[testname] = {}
         results_dict[testname]['discipline'] = discipline
         results_dict[testname][name] = result
+        for metric, value in metrics.items():
+            results_dict[testname][f'{name} {metric}'] = value
 
 
 if __name__ == '__main__':
     args = parser.parse_args()
+    run_timeout = args.timeout
+    if args.oversubscribe:
+        mpirun_flags = '--oversubscribe '
 
     csvfile = open('results.csv', 'w', newline='')
 
@@ -331,9 +374,12 @@ if __name__ == '__main__':
             print(f"=== {model} ===")
             for discipline in args.disciplines:
                 print(f"= {discipline} =")
-                testfiles = glob(f"/rmaracebench/{model}/{discipline}/*.c")
-                testfiles.sort()
-                pool.starmap(run_plain_test, [(f, args.output_folder, model, discipline) for f in testfiles])
+                testfiles = get_testfiles(model, discipline, args.manifest)
+                results = pool.starmap(run_plain_test, [(f, args.output_folder, model, discipline) for f in testfiles])
+                results_append(results_dict, results, model, discipline)
+        pathlib.Path(args.output_folder).mkdir(parents=True, exist_ok=True)
+        df = pandas.DataFrame.from_dict(results_dict, orient='index')
+        df.to_csv(os.path.join(args.output_folder, 'results.csv'))
     elif args.mode == 'tools':
         # Tool runs
         out_prefix = os.path.join('results-' + datetime.now().strftime("%Y%m%d-%H%M%S"))
@@ -341,8 +387,7 @@ if __name__ == '__main__':
             print(f"=== {tool} ===")
             for discipline in args.disciplines:
                 print(f"= {discipline} =")
-                testfiles = glob(f"/rmaracebench/MPIRMA/{discipline}/*.c")
-                testfiles.sort()
+                testfiles = get_testfiles('MPIRMA', discipline, args.manifest)
 
                 results = pool.starmap(run_tool_test, [(f, args.output_folder, tool, discipline) for f in testfiles])
                 results_append(results_dict, results, tool, discipline)
@@ -0,0 +1,51 @@
+# Part of RMARaceBench, under BSD-3-Clause License
+# See https://github.com/RWTH-HPC/RMARaceBench/LICENSE for license information.
+# SPDX-License-Identifier: BSD-3-Clause
+
+# Run from the repository root: python3 -m unittest util/test_manifest.py
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from run_test import get_testfiles
+
+
+class ManifestTest(unittest.TestCase):
+    def generate(self, cwd, output_folder, manifest_file):
+        generate_py = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'generate.py')
+        subprocess.run([sys.executable, generate_py, '--discipline', 'conflict', '-o', output_folder,
+                        '--manifest', manifest_file, '--statistics', os.path.join(output_folder, 'statistics.json')],
+                       cwd=cwd, check=True, stdout=subprocess.DEVNULL)
+
+    def test_output_folder_round_trip(self):
+        """Test cases generated with -o X --manifest X/manifest.json are found by get_testfiles."""
+        repo = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        with tempfile.TemporaryDirectory() as tmp:
+            output_folder = os.path.relpath(tmp, repo)
+            manifest_file = os.path.join(output_folder, 'manifest.json')
+            self.generate(repo, output_folder, manifest_file)
+
+            cases = json.load(open(os.path.join(tmp, 'manifest.json')))['cases']
+            expected = sorted(os.path.join(tmp, case['file']) for case in cases
+                              if case['model'] == 'MPIRMA' and case['discipline'] == 'conflict')
+            self.assertGreater(len(expected), 0)
+            self.assertTrue(all(not os.path.isabs(case['file']) for case in cases))
+
+            cwd = os.getcwd()
+            try:
+                # the manifest is resolved independently of the current folder
+                for folder in [repo, tmp]:
+                    os.chdir(folder)
+                    manifest = os.path.relpath(os.path.join(tmp, 'manifest.json'))
+                    self.assertEqual([os.path.abspath(f) for f in get_testfiles('MPIRMA', 'conflict', manifest)], expected)
+            finally:
+                os.chdir(cwd)
+
+
+if __name__ == '__main__':
+    unittest.main()